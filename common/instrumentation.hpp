@@ -0,0 +1,337 @@
+// Low-overhead instrumentation shared by grid-2d and space-2d.
+//
+// Build with -DINSTRUMENTATION to enable scoped timers, per-thread counters and Chrome trace export
+// (load the exported file in chrome://tracing or https://ui.perfetto.dev).
+// Every INSTRUMENT_SCOPE samples its thread's counters when it ends, so e.g. one sample is taken per render frame.
+// Without it, every INSTRUMENT_* macro compiles to nothing (or to a plain std::lock_guard).
+
+#ifndef GRAPHICS_2D_INSTRUMENTATION_HPP
+#define GRAPHICS_2D_INSTRUMENTATION_HPP
+
+#include <mutex>
+
+#ifdef INSTRUMENTATION
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace instrumentation
+{
+
+enum Counter : unsigned int
+{
+    NODES_EXPANDED,
+    HEAP_PUSHES,
+    HEAP_POPS,
+    BODIES_STEPPED,
+    DRAW_CALLS,
+    LOCK_WAIT_NS,
+    NUM_COUNTERS
+};
+
+inline const char* counterName(const Counter counter)
+{
+    static const char* const names[NUM_COUNTERS] = {"nodes_expanded", "heap_pushes", "heap_pops", "bodies_stepped", "draw_calls", "lock_wait_ns"};
+
+    return names[counter];
+}
+
+// Stop recording timer events and counter samples on a thread past these many; counters keep going.
+constexpr std::size_t MAX_EVENTS_PER_THREAD{1 << 20};
+constexpr std::size_t MAX_SAMPLES_PER_THREAD{1 << 18};
+
+struct TraceEvent
+{
+    // Must point to a string literal; only the pointer is stored.
+    const char* name;
+    std::uint64_t start_us;
+    std::uint64_t duration_us;
+};
+
+struct CounterSample
+{
+    std::uint64_t ts_us;
+    std::array<std::uint64_t, NUM_COUNTERS> values;
+};
+
+// Written only by its owning thread. Counters are atomics (relaxed load/store, no locked add) so they can be
+// read at any time; events must only be read once the owning thread has been joined.
+struct ThreadData
+{
+    unsigned int tid;
+    // Label shown for this thread in the trace viewer; must point to a string literal.
+    const char* name{nullptr};
+    std::array<std::atomic<std::uint64_t>, NUM_COUNTERS> counters{};
+    std::vector<TraceEvent> events;
+    std::vector<CounterSample> samples;
+    std::uint64_t dropped_events{0};
+    std::uint64_t dropped_samples{0};
+};
+
+inline std::chrono::steady_clock::time_point epoch()
+{
+    static const auto start = std::chrono::steady_clock::now();
+
+    return start;
+}
+
+inline std::uint64_t nowMicroseconds()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch()).count();
+}
+
+inline std::mutex& registryMutex()
+{
+    static std::mutex registry_mtx;
+
+    return registry_mtx;
+}
+
+// Owns every thread's data so it outlives the thread and can still be exported after join().
+inline std::vector<std::shared_ptr<ThreadData>>& registry()
+{
+    static std::vector<std::shared_ptr<ThreadData>> threads;
+
+    return threads;
+}
+
+inline std::shared_ptr<ThreadData> registerThread()
+{
+    auto data = std::make_shared<ThreadData>();
+    // Reserve the whole buffer up front so recording never reallocates (and copies) inside a timed scope.
+    // The pages are only committed as events are written.
+    data->events.reserve(MAX_EVENTS_PER_THREAD);
+    data->samples.reserve(MAX_SAMPLES_PER_THREAD);
+
+    const std::lock_guard<std::mutex> lock(registryMutex());
+    auto& threads = registry();
+    data->tid = threads.size();
+    threads.push_back(data);
+
+    return data;
+}
+
+inline ThreadData& threadData()
+{
+    // Registered once per thread; afterwards this is a plain thread-local lookup.
+    thread_local const std::shared_ptr<ThreadData> data = registerThread();
+
+    return *data;
+}
+
+inline void setThreadName(const char* name)
+{
+    threadData().name = name;
+}
+
+inline void add(const Counter counter, const std::uint64_t amount = 1)
+{
+    auto& value = threadData().counters[counter];
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+inline CounterSample snapshotCounters(const ThreadData& data, const std::uint64_t ts_us)
+{
+    CounterSample sample{ts_us, {}};
+
+    for (unsigned int i = 0; i < NUM_COUNTERS; i++)
+    {
+        sample.values[i] = data.counters[i].load(std::memory_order_relaxed);
+    }
+
+    return sample;
+}
+
+// Records a complete event plus a sample of the thread's counters at its end.
+inline void recordEvent(const char* name, const std::uint64_t start_us, const std::uint64_t end_us)
+{
+    auto& data = threadData();
+
+    if (data.events.size() < MAX_EVENTS_PER_THREAD)
+    {
+        data.events.push_back({name, start_us, end_us - start_us});
+    }
+    else
+    {
+        data.dropped_events++;
+    }
+
+    if (data.samples.size() < MAX_SAMPLES_PER_THREAD)
+    {
+        data.samples.push_back(snapshotCounters(data, end_us));
+    }
+    else
+    {
+        data.dropped_samples++;
+    }
+}
+
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(const char* name) : name_(name), start_us_(nowMicroseconds())
+    {
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    ~ScopedTimer()
+    {
+        recordEvent(name_, start_us_, nowMicroseconds());
+    }
+
+private:
+    const char* name_;
+    const std::uint64_t start_us_;
+};
+
+// Drop-in for std::lock_guard that adds the time spent waiting for the mutex to LOCK_WAIT_NS.
+template <typename Mutex>
+class TimedLockGuard
+{
+public:
+    explicit TimedLockGuard(Mutex& mtx) : mtx_(mtx)
+    {
+        const auto wait_start = std::chrono::steady_clock::now();
+        mtx_.lock();
+        const auto wait_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - wait_start).count();
+        add(LOCK_WAIT_NS, wait_ns);
+    }
+
+    TimedLockGuard(const TimedLockGuard&) = delete;
+    TimedLockGuard& operator=(const TimedLockGuard&) = delete;
+
+    ~TimedLockGuard()
+    {
+        mtx_.unlock();
+    }
+
+private:
+    Mutex& mtx_;
+};
+
+inline void writeJsonString(std::ostream& out, const char* str)
+{
+    out << '"';
+
+    for (; *str != '\0'; str++)
+    {
+        if (*str == '"' || *str == '\\')
+        {
+            out << '\\';
+        }
+
+        out << *str;
+    }
+
+    out << '"';
+}
+
+inline void writeCounterSample(std::ostream& out, const unsigned int tid, const CounterSample& sample)
+{
+    out << "{\"name\":\"counters/tid " << tid << "\",\"ph\":\"C\",\"pid\":1,\"tid\":" << tid << ",\"id\":" << tid << ",\"ts\":" << sample.ts_us << ",\"args\":{";
+
+    for (unsigned int i = 0; i < NUM_COUNTERS; i++)
+    {
+        out << (i == 0 ? "" : ",") << "\"" << counterName(static_cast<Counter>(i)) << "\":" << sample.values[i];
+    }
+
+    out << "}}";
+}
+
+// Writes all timer events and counter samples, plus a final sample of the totals at export time, in Chrome trace
+// JSON format. Counter events are keyed by process and name rather than tid, so each thread gets its own
+// "counters/tid N" series. Dropped event/sample counts are reported in the thread_name metadata args.
+// Call only after every instrumented thread (other than the caller) has been joined.
+inline bool writeChromeTrace(const std::string& path)
+{
+    std::ofstream out(path);
+
+    if (!out)
+    {
+        return false;
+    }
+
+    const std::uint64_t end_us = nowMicroseconds();
+    bool first = true;
+
+    auto separator = [&]()
+    {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    const std::lock_guard<std::mutex> lock(registryMutex());
+
+    for (const auto& data : registry())
+    {
+        separator();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << data->tid << ",\"args\":{\"name\":";
+
+        if (data->name != nullptr)
+        {
+            writeJsonString(out, data->name);
+        }
+        else
+        {
+            out << "\"thread " << data->tid << "\"";
+        }
+
+        out << ",\"dropped_events\":" << data->dropped_events << ",\"dropped_samples\":" << data->dropped_samples << "}}";
+
+        for (const auto& event : data->events)
+        {
+            separator();
+            out << "{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << data->tid << ",\"ts\":" << event.start_us << ",\"dur\":" << event.duration_us << "}";
+        }
+
+        for (const auto& sample : data->samples)
+        {
+            separator();
+            writeCounterSample(out, data->tid, sample);
+        }
+
+        separator();
+        writeCounterSample(out, data->tid, snapshotCounters(*data, end_us));
+    }
+
+    out << "\n]}\n";
+
+    return static_cast<bool>(out);
+}
+
+} // namespace instrumentation
+
+#define INSTRUMENT_CONCAT_IMPL(a, b) a##b
+#define INSTRUMENT_CONCAT(a, b) INSTRUMENT_CONCAT_IMPL(a, b)
+
+// Names must be string literals.
+#define INSTRUMENT_THREAD_NAME(name) instrumentation::setThreadName(name)
+#define INSTRUMENT_SCOPE(name) const instrumentation::ScopedTimer INSTRUMENT_CONCAT(instrument_scope_, __LINE__)(name)
+#define INSTRUMENT_COUNT(counter, amount) instrumentation::add(instrumentation::counter, (amount))
+#define INSTRUMENT_LOCK_GUARD(lock, mtx) const instrumentation::TimedLockGuard<std::mutex> lock(mtx)
+#define INSTRUMENT_EXPORT(path) instrumentation::writeChromeTrace(path)
+
+#else
+
+#define INSTRUMENT_THREAD_NAME(name) do {} while (0)
+#define INSTRUMENT_SCOPE(name) do {} while (0)
+#define INSTRUMENT_COUNT(counter, amount) do {} while (0)
+#define INSTRUMENT_LOCK_GUARD(lock, mtx) const std::lock_guard<std::mutex> lock(mtx)
+#define INSTRUMENT_EXPORT(path) (static_cast<void>(0), true)
+
+#endif // INSTRUMENTATION
+
+#endif // GRAPHICS_2D_INSTRUMENTATION_HPP
@@ -6,6 +6,8 @@
 #include <queue>
 #include <vector>
 
+#include "../common/instrumentation.hpp"
+
 constexpr unsigned int NUM_ROWS{5};
 constexpr unsigned int NUM_COLS{5};
 constexpr unsigned int SRC_ROW{1};
@@ -57,43 +59,27 @@ void printPath(std::vector<std::pair<unsigned int, unsigned int>>& path)
     std::cout << "\n";
 }
 
-int main(int argc, char* argv[])
+void runDijkstra(std::vector<std::vector<unsigned int>>& distances, std::vector<std::vector<bool>>& visited, std::vector<std::vector<std::pair<int, int>>>& previous)
 {
+    INSTRUMENT_SCOPE("dijkstra");
+
     std::vector<std::pair<int, int>> moves = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
 
     std::priority_queue<std::pair<unsigned int, std::pair<unsigned int, unsigned int>>, std::vector<std::pair<unsigned int, std::pair<unsigned int, unsigned int>>>, std::greater<std::pair<unsigned int, std::pair<unsigned int, unsigned int>>>> priority_q;
 
-    std::vector<std::vector<char>> grid(NUM_ROWS, std::vector<char>(NUM_COLS, 'o'));
-    std::vector<std::vector<unsigned int>> distances(NUM_ROWS, std::vector<unsigned int>(NUM_COLS, UINT_MAX));
-    std::vector<std::vector<bool>> visited(NUM_ROWS, std::vector<bool>(NUM_COLS, false));
-    std::vector<std::vector<std::pair<int, int>>> previous(NUM_ROWS, std::vector<std::pair<int, int>>(NUM_COLS, {-1, -1}));
-
-    // Initialize source vertex.
-    grid[SRC_ROW][SRC_COL] = 'a';
-    distances[SRC_ROW][SRC_COL] = SRC_WEIGHT;
-
-    // Initialize destination vertex.
-    grid[DEST_ROW][DEST_COL] = 'z';
-
-    printMatrix(grid);
-    std::cout << "--------\n";
-    printMatrix(distances);
-    std::cout << "--------\n";
-    printMatrix(visited);
-    std::cout << "--------\n";
-    printMatrix(previous);
-    std::cout << "--------\n";
-
     priority_q.push({SRC_WEIGHT, {SRC_ROW, SRC_COL}});
+    INSTRUMENT_COUNT(HEAP_PUSHES, 1);
 
     while (!priority_q.empty())
     {
         auto current_vertex = priority_q.top();
         priority_q.pop();
+        INSTRUMENT_COUNT(HEAP_POPS, 1);
         auto current_weight = current_vertex.first;
         auto current_r_i = current_vertex.second.first;
         auto current_c_i = current_vertex.second.second;
         visited[current_r_i][current_c_i] = true;
+        INSTRUMENT_COUNT(NODES_EXPANDED, 1);
 
         // Find all adjacent vertices.
         for (unsigned int i = 0; i < moves.size(); i++)
@@ -116,11 +102,40 @@ int main(int argc, char* argv[])
                         distances[adj_vertex_r_i][adj_vertex_c_i] = new_weight;
                         previous[adj_vertex_r_i][adj_vertex_c_i] = {current_r_i, current_c_i};
                         priority_q.push({new_weight, {adj_vertex_r_i, adj_vertex_c_i}});
+                        INSTRUMENT_COUNT(HEAP_PUSHES, 1);
                     }
                 }
             }
         }
     }
+}
+
+int main(int argc, char* argv[])
+{
+    INSTRUMENT_THREAD_NAME("main");
+
+    std::vector<std::vector<char>> grid(NUM_ROWS, std::vector<char>(NUM_COLS, 'o'));
+    std::vector<std::vector<unsigned int>> distances(NUM_ROWS, std::vector<unsigned int>(NUM_COLS, UINT_MAX));
+    std::vector<std::vector<bool>> visited(NUM_ROWS, std::vector<bool>(NUM_COLS, false));
+    std::vector<std::vector<std::pair<int, int>>> previous(NUM_ROWS, std::vector<std::pair<int, int>>(NUM_COLS, {-1, -1}));
+
+    // Initialize source vertex.
+    grid[SRC_ROW][SRC_COL] = 'a';
+    distances[SRC_ROW][SRC_COL] = SRC_WEIGHT;
+
+    // Initialize destination vertex.
+    grid[DEST_ROW][DEST_COL] = 'z';
+
+    printMatrix(grid);
+    std::cout << "--------\n";
+    printMatrix(distances);
+    std::cout << "--------\n";
+    printMatrix(visited);
+    std::cout << "--------\n";
+    printMatrix(previous);
+    std::cout << "--------\n";
+
+    runDijkstra(distances, visited, previous);
 
     printMatrix(grid);
     std::cout << "--------\n";
@@ -151,5 +166,10 @@ int main(int argc, char* argv[])
 
     printPath(shortest_path);
 
+    if (!INSTRUMENT_EXPORT("dijkstraGrid_trace.json"))
+    {
+        std::cerr << "Could not write trace file dijkstraGrid_trace.json.\n";
+    }
+
     return 0;
 }
@@ -13,6 +13,8 @@
 // Needs to be included after <SFML/Graphics.hpp>!
 #include <X11/Xlib.h>
 
+#include "../common/instrumentation.hpp"
+
 constexpr unsigned int WINDOW_LENGTH{1920};
 constexpr unsigned int WINDOW_HEIGHT{1200};
 constexpr unsigned int NUM_ROWS{10};
@@ -190,11 +192,15 @@ private:
 
 void render(sf::RenderWindow& window, const std::shared_ptr<Grid> grid)
 {
+    INSTRUMENT_THREAD_NAME("render");
+
     while (window.isOpen())
     {
+        INSTRUMENT_SCOPE("render_frame");
+
         window.clear();
 
-        const std::lock_guard<std::mutex> lock(MTX);
+        INSTRUMENT_LOCK_GUARD(lock, MTX);
 
         for (unsigned int i = 0; i < NUM_ROWS; i++)
         {
@@ -213,6 +219,9 @@ void render(sf::RenderWindow& window, const std::shared_ptr<Grid> grid)
             }
         }
 
+        // Count once per frame to keep the critical section short.
+        INSTRUMENT_COUNT(DRAW_CALLS, NUM_ROWS * NUM_COLS * (grid->show_weights_ ? 2 : 1));
+
         window.display();
     }
 }
@@ -222,12 +231,15 @@ unsigned int a = 1;
 unsigned int b = 1;
 void buildPath(const std::shared_ptr<Grid> grid)
 {
+    INSTRUMENT_THREAD_NAME("path");
+
     unsigned int num_cells = 4;
     
     for (unsigned int i = 0; i < num_cells; i++)
     {
         {
-            const std::lock_guard<std::mutex> lock(MTX);
+            INSTRUMENT_SCOPE("add_path");
+            INSTRUMENT_LOCK_GUARD(lock, MTX);
 
             grid->addPath(a, b);
             a++;
@@ -282,6 +294,8 @@ int main(int argc, char const* argv[])
     // Make sure cell length and height match; cells needs to be a square!
     assert(CELL_HEIGHT == CELL_LENGTH);
 
+    INSTRUMENT_THREAD_NAME("main");
+
     // Breaks cross-platform support! 
     // Is not reliable, but sometimes needs to calledso X is aware that this is a multi-threaded application.
     XInitThreads();
@@ -330,5 +344,10 @@ int main(int argc, char const* argv[])
     path_thread.join();
     //dijkstra_thread.join();
 
+    if (!INSTRUMENT_EXPORT("grid2d_trace.json"))
+    {
+        std::cerr << "Could not write trace file grid2d_trace.json.\n";
+    }
+
     return 0;
 }
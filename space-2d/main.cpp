@@ -7,6 +7,8 @@
 // Needs to be included after <SFML/Graphics.hpp>!
 #include <X11/Xlib.h>
 
+#include "../common/instrumentation.hpp"
+
 std::mutex MTX;
 
 class Planet : public sf::CircleShape
@@ -95,23 +97,31 @@ constexpr int WINDOW_HEIGHT{600}; //1200;
 
 void renderThread(sf::RenderWindow& window, sf::Clock& clock, const std::vector<std::unique_ptr<Planet>>& planets)
 {
+    INSTRUMENT_THREAD_NAME("render");
+
     // Do not need to explicitly activate window; SFML will do it automatically.
     //window.setActive(true);
 
     while (window.isOpen())
     {
+        INSTRUMENT_SCOPE("render_frame");
+
         window.clear();
 
         const sf::Time elapsed = clock.restart();
         const auto dt = elapsed.asSeconds();
         
         // Critical section; shared resource being planets.	
-        const std::lock_guard<std::mutex> lock(MTX);
+        INSTRUMENT_LOCK_GUARD(lock, MTX);
        
        	for (const auto& planet : planets) {
             planet->applyMotion(dt);
             window.draw(*planet);
         }
+
+        // Count once per frame to keep the critical section short.
+        INSTRUMENT_COUNT(BODIES_STEPPED, planets.size());
+        INSTRUMENT_COUNT(DRAW_CALLS, planets.size());
         
         window.display();
     }
@@ -119,6 +129,8 @@ void renderThread(sf::RenderWindow& window, sf::Clock& clock, const std::vector<
 
 int main(int argc, char* argv[])
 {
+    INSTRUMENT_THREAD_NAME("main");
+
     // Breaks cross-platform support! 
     // Is not reliable, but sometimes needs to calledso X is aware that this is a multi-threaded application.
     XInitThreads();
@@ -159,12 +171,14 @@ int main(int argc, char* argv[])
                 // Need to define scope in case statement to be able to create new variables/objects (e.g. planet)!
                 case sf::Event::MouseButtonReleased:
                 {
+                    INSTRUMENT_SCOPE("add_planet");
+
                     std::unique_ptr<Planet> planet = std::make_unique<Planet>(20, sf::Color::Green, event.mouseButton.x, event.mouseButton.y);
                     planet->setVelocity(50, 50);
                     planet->setAcceleration(100, 100);
                     
                     // Critical section; shared resource being planets.
-                    const std::lock_guard<std::mutex> lock(MTX);
+                    INSTRUMENT_LOCK_GUARD(lock, MTX);
                     // Move ownership of std::unique_ptr; cannot copy!
                     planets.emplace_back(std::move(planet));
                     break;
@@ -178,5 +192,10 @@ int main(int argc, char* argv[])
 
     render_thread.join();
 
+    if (!INSTRUMENT_EXPORT("space2d_trace.json"))
+    {
+        std::cerr << "Could not write trace file space2d_trace.json.\n";
+    }
+
     return 0;
 }